@@ -77,7 +77,7 @@ hashhandler(PG_FUNCTION_ARGS)
 	amroutine->amclusterable = false;
 	amroutine->ampredlocks = true;
 	amroutine->amcanparallel = false;
-	amroutine->amcanbuildparallel = false;
+	amroutine->amcanbuildparallel = true;
 	amroutine->amcaninclude = false;
 	amroutine->amusemaintenanceworkmem = false;
 	amroutine->amsummarizing = false;
@@ -167,8 +167,13 @@ hashbuild(Relation heap, Relation index, IndexInfo *indexInfo)
 	else
 		sort_threshold = Min(sort_threshold, NLocBuffer);
 
+	/*
+	 * Only the sorted build can use parallel workers, since they scan the
+	 * heap and sort their share of the tuples but cannot insert into the
+	 * index; the leader does that in _h_indexbuild().
+	 */
 	if (num_buckets >= sort_threshold)
-		buildstate.spool = _h_spoolinit(heap, index, num_buckets);
+		buildstate.spool = _h_spoolinit(heap, index, num_buckets, indexInfo);
 	else
 		buildstate.spool = NULL;
 
@@ -176,10 +181,14 @@ hashbuild(Relation heap, Relation index, IndexInfo *indexInfo)
 	buildstate.indtuples = 0;
 	buildstate.heapRel = heap;
 
-	/* do the heap scan */
-	reltuples = table_index_build_scan(heap, index, indexInfo, true, true,
-									   hashbuildCallback,
-									   &buildstate, NULL);
+	/* do the heap scan, or collect the results of the parallel one */
+	if (buildstate.spool && _h_spoolisparallel(buildstate.spool))
+		reltuples = _h_parallel_heapscan(buildstate.spool,
+										 &buildstate.indtuples);
+	else
+		reltuples = table_index_build_scan(heap, index, indexInfo, true, true,
+										   hashbuildCallback,
+										   &buildstate, NULL);
 	pgstat_progress_update_param(PROGRESS_CREATEIDX_TUPLES_TOTAL,
 								 buildstate.indtuples);
 
@@ -21,8 +21,11 @@
 #include "access/nbtree.h"
 #include "access/relscan.h"
 #include "access/stratnum.h"
+#include "access/visibilitymap.h"
+#include "catalog/catalog.h"
 #include "commands/progress.h"
 #include "commands/vacuum.h"
+#include "executor/instrument.h"
 #include "nodes/execnodes.h"
 #include "pgstat.h"
 #include "storage/bulk_write.h"
@@ -34,8 +37,15 @@
 #include "utils/fmgrprotos.h"
 #include "utils/index_selfuncs.h"
 #include "utils/memutils.h"
+#include "utils/spccache.h"
 
 
+/*
+ * Number of tuples a plain or index-only scan returns before we start to
+ * prefetch heap blocks for it, see _bt_prefetch_heap.
+ */
+#define BT_PREFETCH_DELAY	4
+
 /*
  * BTPARALLEL_NOT_INITIALIZED indicates that the scan has not started.
  *
@@ -88,6 +98,7 @@ static void btvacuumscan(IndexVacuumInfo *info, IndexBulkDeleteResult *stats,
 						 IndexBulkDeleteCallback callback, void *callback_state,
 						 BTCycleId cycleid);
 static BlockNumber btvacuumpage(BTVacState *vstate, Buffer buf);
+static void _bt_prefetch_heap(IndexScanDesc scan, ScanDirection dir);
 static BTVacuumPosting btreevacuumposting(BTVacState *vstate,
 										  IndexTuple posting,
 										  OffsetNumber updatedoffset,
@@ -263,9 +274,99 @@ btgettuple(IndexScanDesc scan, ScanDirection dir)
 		/* ... otherwise see if we need another primitive index scan */
 	} while (so->numArrayKeys && _bt_start_prim_scan(scan, dir));
 
+	if (res && so->prefetchDistance > 0)
+		_bt_prefetch_heap(scan, dir);
+
 	return res;
 }
 
+/*
+ * _bt_prefetch_heap() -- prefetch heap blocks for upcoming items
+ *
+ * The caller is about to fetch the heap tuple for the current item.  Issue
+ * prefetches for the heap blocks of the next prefetchTarget items on the
+ * current leaf page, so that their I/O can proceed in the background while
+ * the caller works through the preceding ones.  Items that were prefetched
+ * already, as tracked by the position's prefetchIndex, are not redone.  We
+ * never look beyond the current leaf page.
+ *
+ * Many index scans return only a handful of tuples (LIMIT, EXISTS, inner
+ * side of a nestloop), so we don't start until the scan has returned
+ * BT_PREFETCH_DELAY tuples.  And prefetching only pays off for blocks that
+ * aren't in shared buffers, so from there on we only look ahead while the
+ * scan keeps reading blocks in, going twice as far each time it has, and
+ * back off by one item for every prefetched block that turns out to be in
+ * shared buffers already.  Scans of cached data thus don't prefetch at all.
+ *
+ * For index-only scans, blocks marked all-visible won't be visited at all,
+ * so we don't prefetch those.
+ */
+static void
+_bt_prefetch_heap(IndexScanDesc scan, ScanDirection dir)
+{
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	BTScanPos	pos = &so->currPos;
+	int			start;
+	int			end;
+	int64		nread;
+
+	if (so->prefetchTarget < 0)
+	{
+		/* still waiting for the scan to return enough tuples */
+		so->prefetchTarget++;
+		return;
+	}
+
+	/* Has the scan read any blocks since last time? */
+	nread = pgBufferUsage.shared_blks_read + pgBufferUsage.local_blks_read;
+	if (nread != so->prefetchNread)
+	{
+		so->prefetchNread = nread;
+		so->prefetchTarget = Max(Min(so->prefetchTarget * 2,
+									 so->prefetchDistance), 1);
+	}
+	if (so->prefetchTarget == 0)
+		return;
+
+	if (ScanDirectionIsForward(dir))
+	{
+		start = Max(pos->prefetchIndex, pos->itemIndex) + 1;
+		end = Min(pos->itemIndex + so->prefetchTarget, pos->lastItem);
+		if (start > end)
+			return;
+		pos->prefetchIndex = end;
+	}
+	else
+	{
+		start = Max(pos->itemIndex - so->prefetchTarget, pos->firstItem);
+		end = Min(pos->prefetchIndex, pos->itemIndex) - 1;
+		if (start > end)
+			return;
+		pos->prefetchIndex = start;
+	}
+
+	for (int i = start; i <= end; i++)
+	{
+		/* visit the items in scan order */
+		int			item = ScanDirectionIsForward(dir) ? i : end - (i - start);
+		BlockNumber blkno = ItemPointerGetBlockNumber(&pos->items[item].heapTid);
+		PrefetchBufferResult result;
+
+		if (blkno == so->prefetchBlock)
+			continue;
+		so->prefetchBlock = blkno;
+
+		if (scan->xs_want_itup &&
+			VM_ALL_VISIBLE(scan->heapRelation, blkno, &so->vmBuffer))
+			continue;
+
+		result = PrefetchBuffer(scan->heapRelation, MAIN_FORKNUM, blkno);
+
+		if (BufferIsValid(result.recent_buffer) && so->prefetchTarget > 0)
+			so->prefetchTarget--;
+	}
+}
+
 /*
  * btgetbitmap() -- gets all matching tuples, and adds them to a bitmap
  */
@@ -346,6 +447,14 @@ btbeginscan(Relation rel, int nkeys, int norderbys)
 	so->killedItems = NULL;		/* until needed */
 	so->numKilled = 0;
 
+	/* the heap relation isn't set yet, so btrescan sets up prefetching */
+	so->prefetchDistance = -1;
+	so->prefetchTarget = -BT_PREFETCH_DELAY;
+	so->prefetchNread = pgBufferUsage.shared_blks_read +
+		pgBufferUsage.local_blks_read;
+	so->prefetchBlock = InvalidBlockNumber;
+	so->vmBuffer = InvalidBuffer;
+
 	/*
 	 * We don't know yet whether the scan will be index-only, so we do not
 	 * allocate the tuple workspace arrays until btrescan.  However, we set up
@@ -383,9 +492,32 @@ btrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
 	so->needPrimScan = false;
 	so->scanBehind = false;
 	so->oppositeDirCheck = false;
+	so->prefetchTarget = -BT_PREFETCH_DELAY;
+	so->prefetchNread = pgBufferUsage.shared_blks_read +
+		pgBufferUsage.local_blks_read;
+	so->prefetchBlock = InvalidBlockNumber;
 	BTScanPosUnpinIfPinned(so->markPos);
 	BTScanPosInvalidate(so->markPos);
 
+	/*
+	 * On the first call, decide how far ahead of plain and index-only scans
+	 * to prefetch heap blocks, as effective_io_concurrency for the heap's
+	 * tablespace allows.  We don't bother for catalogs, which are small and
+	 * usually cached, and whose scans can happen while looking up the
+	 * tablespace setting itself.  Bitmap scans have no heap relation here,
+	 * but they don't go through btgettuple anyway.
+	 */
+	if (so->prefetchDistance < 0)
+	{
+		so->prefetchDistance = 0;
+#ifdef USE_PREFETCH
+		if (scan->heapRelation != NULL &&
+			!IsCatalogRelation(scan->heapRelation))
+			so->prefetchDistance =
+				get_tablespace_io_concurrency(scan->heapRelation->rd_rel->reltablespace);
+#endif
+	}
+
 	/*
 	 * Allocate tuple workspace arrays, if needed for an index-only scan and
 	 * not already done in a previous rescan call.  To save on palloc
@@ -439,6 +571,9 @@ btendscan(IndexScanDesc scan)
 
 	/* No need to invalidate positions, the RAM is about to be freed. */
 
+	if (BufferIsValid(so->vmBuffer))
+		ReleaseBuffer(so->vmBuffer);
+
 	/* Release storage */
 	if (so->keyData != NULL)
 		pfree(so->keyData);
@@ -145,7 +145,11 @@ int			wal_segment_size = DEFAULT_XLOG_SEG_SIZE;
 /*
  * Number of WAL insertion locks to use. A higher value allows more insertions
  * to happen concurrently, but adds some CPU overhead to flushing the WAL,
- * which needs to iterate all the locks.
+ * which needs to iterate all the locks.  Each inserter holds a lock only
+ * while copying its record into the WAL buffers, so too few locks make
+ * concurrent inserters queue behind each other; but every
+ * WaitXLogInsertionsToFinish() call checks all of them, one atomic read per
+ * free lock, and that cost is paid even when there is no concurrency.
  */
 #define NUM_XLOGINSERT_LOCKS  8
 
@@ -24,8 +24,9 @@
  *	  All notification messages are placed in the queue and later read out
  *	  by listening backends.
  *
- *	  There is no central knowledge of which backend listens on which channel;
- *	  every backend has its own list of interesting channels.
+ *	  There is no exact central knowledge of which backend listens on which
+ *	  channel; every backend has its own list of interesting channels, and
+ *	  only advertises an approximation of it in shared memory (see below).
  *
  *	  Although there is only one queue, notifications are treated as being
  *	  database-local; this is done by including the sender's database OID
@@ -72,12 +73,16 @@
  *	  Then we signal any backends that may be interested in our messages
  *	  (including our own backend, if listening).  This is done by
  *	  SignalBackends(), which scans the list of listening backends and sends a
- *	  PROCSIG_NOTIFY_INTERRUPT signal to every listening backend (we don't
- *	  know which backend is listening on which channel so we must signal them
- *	  all).  We can exclude backends that are already up to date, though, and
- *	  we can also exclude backends that are in other databases (unless they
- *	  are way behind and should be kicked to make them advance their
- *	  pointers).
+ *	  PROCSIG_NOTIFY_INTERRUPT signal to those in our database that may be
+ *	  listening on one of the channels we notified.  For that, each listener
+ *	  advertises a 64-bit bloom filter of its channels (channelMask) in its
+ *	  AsyncQueueControl entry; a hash collision just causes a useless signal.
+ *	  The bits for new channels are set in PreCommit_Notify(), before the
+ *	  LISTEN commits, so that a notifier committing after that is sure to see
+ *	  them; the mask is recomputed after an UNLISTEN commits.  We also exclude
+ *	  backends that are already up to date.  Backends that are in other
+ *	  databases, or not interested in our channels, are signaled only if they
+ *	  are way behind and should be kicked to make them advance their pointers.
  *
  *	  Finally, after we are out of the transaction altogether and about to go
  *	  idle, we scan the queue for messages that need to be sent to our
@@ -246,8 +251,19 @@ typedef struct QueueBackendStatus
 	Oid			dboid;			/* backend's database OID, or InvalidOid */
 	ProcNumber	nextListener;	/* id of next listener, or INVALID_PROC_NUMBER */
 	QueuePosition pos;			/* backend has read queue up to here */
+	uint64		channelMask;	/* CHANNEL_MASK_BIT()s of listened channels */
 } QueueBackendStatus;
 
+/*
+ * Each listener advertises a small bloom filter of the channels it listens
+ * on, so that a notifying backend can skip waking listeners that cannot be
+ * interested in any of its notifications.  A hash collision merely causes an
+ * unnecessary wakeup, as before.
+ */
+#define CHANNEL_MASK_BIT(channel) \
+	(UINT64CONST(1) << (hash_bytes((const unsigned char *) (channel), \
+								   strlen(channel)) & 63))
+
 /*
  * Shared memory state for LISTEN/NOTIFY (excluding its SLRU stuff)
  *
@@ -301,6 +317,7 @@ static AsyncQueueControl *asyncQueueControl;
 #define QUEUE_BACKEND_DBOID(i)		(asyncQueueControl->backend[i].dboid)
 #define QUEUE_NEXT_LISTENER(i)		(asyncQueueControl->backend[i].nextListener)
 #define QUEUE_BACKEND_POS(i)		(asyncQueueControl->backend[i].pos)
+#define QUEUE_BACKEND_CHANNEL_MASK(i)	(asyncQueueControl->backend[i].channelMask)
 
 /*
  * The SLRU buffer area through which we access the notification queue
@@ -527,6 +544,7 @@ AsyncShmemInit(void)
 			QUEUE_BACKEND_DBOID(i) = InvalidOid;
 			QUEUE_NEXT_LISTENER(i) = INVALID_PROC_NUMBER;
 			SET_QUEUE_POS(QUEUE_BACKEND_POS(i), 0, 0);
+			QUEUE_BACKEND_CHANNEL_MASK(i) = 0;
 		}
 	}
 
@@ -871,6 +889,8 @@ PreCommit_Notify(void)
 	/* Preflight for any pending listen/unlisten actions */
 	if (pendingActions != NULL)
 	{
+		uint64		listenMask = 0;
+
 		foreach(p, pendingActions->actions)
 		{
 			ListenAction *actrec = (ListenAction *) lfirst(p);
@@ -879,6 +899,7 @@ PreCommit_Notify(void)
 			{
 				case LISTEN_LISTEN:
 					Exec_ListenPreCommit();
+					listenMask |= CHANNEL_MASK_BIT(actrec->channel);
 					break;
 				case LISTEN_UNLISTEN:
 					/* there is no Exec_UnlistenPreCommit() */
@@ -888,6 +909,20 @@ PreCommit_Notify(void)
 					break;
 			}
 		}
+
+		/*
+		 * Advertise the channels we are about to listen on before we commit,
+		 * so that anyone who commits a notification after us will know to
+		 * signal us.  If we abort, the extra bits just cause some needless
+		 * wakeups until our next UNLISTEN commits.  We need only shared lock
+		 * to update our own entry.
+		 */
+		if (listenMask != 0)
+		{
+			LWLockAcquire(NotifyQueueLock, LW_SHARED);
+			QUEUE_BACKEND_CHANNEL_MASK(MyProcNumber) |= listenMask;
+			LWLockRelease(NotifyQueueLock);
+		}
 	}
 
 	/* Queue any pending notifies (must happen after the above) */
@@ -1004,6 +1039,18 @@ AtCommit_Notify(void)
 	/* If no longer listening to anything, get out of listener array */
 	if (amRegisteredListener && listenChannels == NIL)
 		asyncQueueUnregister();
+	else if (amRegisteredListener && pendingActions != NULL)
+	{
+		uint64		listenMask = 0;
+
+		/* Drop the bits of any channels we've stopped listening on */
+		foreach(p, listenChannels)
+			listenMask |= CHANNEL_MASK_BIT((char *) lfirst(p));
+
+		LWLockAcquire(NotifyQueueLock, LW_SHARED);
+		QUEUE_BACKEND_CHANNEL_MASK(MyProcNumber) = listenMask;
+		LWLockRelease(NotifyQueueLock);
+	}
 
 	/*
 	 * Send signals to listening backends.  We need do this only if there are
@@ -1099,6 +1146,7 @@ Exec_ListenPreCommit(void)
 	QUEUE_BACKEND_POS(MyProcNumber) = max;
 	QUEUE_BACKEND_PID(MyProcNumber) = MyProcPid;
 	QUEUE_BACKEND_DBOID(MyProcNumber) = MyDatabaseId;
+	QUEUE_BACKEND_CHANNEL_MASK(MyProcNumber) = 0;
 	/* Insert backend into list of listeners at correct position */
 	if (prevListener != INVALID_PROC_NUMBER)
 	{
@@ -1242,6 +1290,7 @@ asyncQueueUnregister(void)
 	/* Mark our entry as invalid */
 	QUEUE_BACKEND_PID(MyProcNumber) = InvalidPid;
 	QUEUE_BACKEND_DBOID(MyProcNumber) = InvalidOid;
+	QUEUE_BACKEND_CHANNEL_MASK(MyProcNumber) = 0;
 	/* and remove it from the list */
 	if (QUEUE_FIRST_LISTENER == MyProcNumber)
 		QUEUE_FIRST_LISTENER = QUEUE_NEXT_LISTENER(MyProcNumber);
@@ -1565,12 +1614,13 @@ asyncQueueFillWarning(void)
 /*
  * Send signals to listening backends.
  *
- * Normally we signal only backends in our own database, since only those
- * backends could be interested in notifies we send.  However, if there's
- * notify traffic in our database but no traffic in another database that
- * does have listener(s), those listeners will fall further and further
- * behind.  Waken them anyway if they're far enough behind, so that they'll
- * advance their queue position pointers, allowing the global tail to advance.
+ * Normally we signal only backends in our own database that listen on (or
+ * whose channel mask collides with) at least one of the channels we sent
+ * notifies on, since only those backends could be interested in them.
+ * However, if there's notify traffic that some listener never sees, that
+ * listener will fall further and further behind.  Waken it anyway if it's
+ * far enough behind, so that it'll advance its queue position pointer,
+ * allowing the global tail to advance.
  *
  * Since we know the ProcNumber and the Pid the signaling is quite cheap.
  *
@@ -1583,6 +1633,16 @@ SignalBackends(void)
 	int32	   *pids;
 	ProcNumber *procnos;
 	int			count;
+	uint64		notifyMask = 0;
+	ListCell   *p;
+
+	/* Compute the mask of channels we sent notifies on */
+	foreach(p, pendingNotifies->events)
+	{
+		Notification *n = (Notification *) lfirst(p);
+
+		notifyMask |= CHANNEL_MASK_BIT(n->data);
+	}
 
 	/*
 	 * Identify backends that we need to signal.  We don't want to send
@@ -1604,11 +1664,12 @@ SignalBackends(void)
 
 		Assert(pid != InvalidPid);
 		pos = QUEUE_BACKEND_POS(i);
-		if (QUEUE_BACKEND_DBOID(i) == MyDatabaseId)
+		if (QUEUE_BACKEND_DBOID(i) == MyDatabaseId &&
+			(QUEUE_BACKEND_CHANNEL_MASK(i) & notifyMask) != 0)
 		{
 			/*
-			 * Always signal listeners in our own database, unless they're
-			 * already caught up (unlikely, but possible).
+			 * Always signal interested listeners in our own database, unless
+			 * they're already caught up (unlikely, but possible).
 			 */
 			if (QUEUE_POS_EQUAL(pos, QUEUE_HEAD))
 				continue;
@@ -1616,8 +1677,8 @@ SignalBackends(void)
 		else
 		{
 			/*
-			 * Listeners in other databases should be signaled only if they
-			 * are far behind.
+			 * Listeners in other databases, or that don't listen on any of
+			 * our channels, should be signaled only if they are far behind.
 			 */
 			if (asyncQueuePageDiff(QUEUE_POS_PAGE(QUEUE_HEAD),
 								   QUEUE_POS_PAGE(pos)) < QUEUE_CLEANUP_DELAY)
@@ -71,7 +71,9 @@
 #include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "pgstat.h"
+#include "port/pg_bitutils.h"
 #include "port/pg_bswap.h"
+#include "port/simd.h"
 #include "utils/builtins.h"
 #include "utils/rel.h"
 
@@ -141,6 +143,8 @@ static const char BinarySignature[11] = "PGCOPY\n\377\r\n\0";
 
 /* non-export function prototypes */
 static bool CopyReadLine(CopyFromState cstate, bool is_csv);
+static inline int CopySkipPlainBytes(const char *buf, int len,
+									 char c1, char c2, char c3, char c4);
 static bool CopyReadLineText(CopyFromState cstate, bool is_csv);
 static int	CopyReadAttributesText(CopyFromState cstate);
 static int	CopyReadAttributesCSV(CopyFromState cstate);
@@ -1227,6 +1231,48 @@ CopyReadLine(CopyFromState cstate, bool is_csv)
 	return result;
 }
 
+/*
+ * CopySkipPlainBytes - find the first special character in a buffer
+ *
+ * Returns the number of leading bytes of buf[0..len) that are none of c1..c4,
+ * examining the input sizeof(Vector8) bytes at a time.  Only whole vectors
+ * are examined, so if no special character is found the result is len
+ * rounded down to a multiple of the vector size; callers must continue with
+ * their byte-at-a-time loop from the returned position.  Without SIMD
+ * support, this always returns 0.
+ */
+static inline int
+CopySkipPlainBytes(const char *buf, int len, char c1, char c2, char c3, char c4)
+{
+#ifndef USE_NO_SIMD
+	const Vector8 v1 = vector8_broadcast((uint8) c1);
+	const Vector8 v2 = vector8_broadcast((uint8) c2);
+	const Vector8 v3 = vector8_broadcast((uint8) c3);
+	const Vector8 v4 = vector8_broadcast((uint8) c4);
+	int			i;
+
+	for (i = 0; i + (int) sizeof(Vector8) <= len; i += sizeof(Vector8))
+	{
+		Vector8		chunk;
+		Vector8		match;
+		uint32		mask;
+
+		vector8_load(&chunk, (const uint8 *) buf + i);
+		match = vector8_or(vector8_or(vector8_eq(chunk, v1),
+									  vector8_eq(chunk, v2)),
+						   vector8_or(vector8_eq(chunk, v3),
+									  vector8_eq(chunk, v4)));
+		mask = vector8_highbit_mask(match);
+		if (mask != 0)
+			return i + pg_rightmost_one_pos32(mask);
+	}
+
+	return i;
+#else
+	return 0;
+#endif
+}
+
 /*
  * CopyReadLineText - inner loop of CopyReadLine for text mode
  */
@@ -1319,6 +1365,28 @@ CopyReadLineText(CopyFromState cstate, bool is_csv)
 			need_data = false;
 		}
 
+		/*
+		 * Skip quickly over any run of bytes that can neither end the line
+		 * nor change the quoting state.  In CSV mode such bytes are never
+		 * the escape character, so they clear last_was_esc.
+		 */
+		{
+			int			nplain;
+
+			nplain = CopySkipPlainBytes(copy_input_buf + input_buf_ptr,
+										copy_buf_len - input_buf_ptr,
+										'\n', '\r',
+										is_csv ? quotec : '\\',
+										is_csv ? escapec : '\\');
+			if (nplain > 0)
+			{
+				input_buf_ptr += nplain;
+				last_was_esc = false;
+				if (input_buf_ptr >= copy_buf_len)
+					continue;
+			}
+		}
+
 		/* OK to fetch a character */
 		prev_raw_ptr = input_buf_ptr;
 		c = copy_input_buf[input_buf_ptr++];
@@ -1635,6 +1703,17 @@ CopyReadAttributesText(CopyFromState cstate)
 		for (;;)
 		{
 			char		c;
+			int			nplain;
+
+			/* Copy any run of ordinary characters in bulk */
+			nplain = CopySkipPlainBytes(cur_ptr, line_end_ptr - cur_ptr,
+										delimc, '\\', '\\', '\\');
+			if (nplain > 0)
+			{
+				memcpy(output_ptr, cur_ptr, nplain);
+				output_ptr += nplain;
+				cur_ptr += nplain;
+			}
 
 			end_ptr = cur_ptr;
 			if (cur_ptr >= line_end_ptr)
@@ -1887,10 +1966,21 @@ CopyReadAttributesCSV(CopyFromState cstate)
 		for (;;)
 		{
 			char		c;
+			int			nplain;
 
 			/* Not in quote */
 			for (;;)
 			{
+				/* Copy any run of ordinary characters in bulk */
+				nplain = CopySkipPlainBytes(cur_ptr, line_end_ptr - cur_ptr,
+											delimc, quotec, quotec, quotec);
+				if (nplain > 0)
+				{
+					memcpy(output_ptr, cur_ptr, nplain);
+					output_ptr += nplain;
+					cur_ptr += nplain;
+				}
+
 				end_ptr = cur_ptr;
 				if (cur_ptr >= line_end_ptr)
 					goto endfield;
@@ -1914,6 +2004,15 @@ CopyReadAttributesCSV(CopyFromState cstate)
 			/* In quote */
 			for (;;)
 			{
+				nplain = CopySkipPlainBytes(cur_ptr, line_end_ptr - cur_ptr,
+											escapec, quotec, quotec, quotec);
+				if (nplain > 0)
+				{
+					memcpy(output_ptr, cur_ptr, nplain);
+					output_ptr += nplain;
+					cur_ptr += nplain;
+				}
+
 				end_ptr = cur_ptr;
 				if (cur_ptr >= line_end_ptr)
 					ereport(ERROR,
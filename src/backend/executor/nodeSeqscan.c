@@ -28,13 +28,16 @@
 #include "postgres.h"
 
 #include "access/relscan.h"
+#include "access/sysattr.h"
 #include "access/tableam.h"
 #include "executor/execScan.h"
 #include "executor/executor.h"
 #include "executor/nodeSeqscan.h"
+#include "optimizer/optimizer.h"
 #include "utils/rel.h"
 
 static TupleTableSlot *SeqNext(SeqScanState *node);
+static Bitmapset *SeqScanProjectedAttrs(SeqScanState *node);
 
 /* ----------------------------------------------------------------
  *						Scan Support
@@ -72,6 +75,7 @@ SeqNext(SeqScanState *node)
 		scandesc = table_beginscan(node->ss.ss_currentRelation,
 								   estate->es_snapshot,
 								   0, NULL);
+		table_scan_set_projection(scandesc, node->projected_attrs);
 		node->ss.ss_currentScanDesc = scandesc;
 	}
 
@@ -83,6 +87,36 @@ SeqNext(SeqScanState *node)
 	return NULL;
 }
 
+/*
+ * SeqScanProjectedAttrs -- compute the set of columns the scan has to return
+ *
+ * This covers everything referenced by the node's qual and targetlist, using
+ * the representation of pull_varattnos().  A whole-row reference is expanded
+ * to all of the relation's columns.
+ */
+static Bitmapset *
+SeqScanProjectedAttrs(SeqScanState *node)
+{
+	Plan	   *plan = node->ss.ps.plan;
+	Index		scanrelid = ((Scan *) plan)->scanrelid;
+	Bitmapset  *attrs = NULL;
+
+	pull_varattnos((Node *) plan->targetlist, scanrelid, &attrs);
+	pull_varattnos((Node *) plan->qual, scanrelid, &attrs);
+
+	if (bms_is_member(InvalidAttrNumber - FirstLowInvalidHeapAttributeNumber,
+					  attrs))
+	{
+		TupleDesc	tupdesc = RelationGetDescr(node->ss.ss_currentRelation);
+
+		for (int i = 1; i <= tupdesc->natts; i++)
+			attrs = bms_add_member(attrs,
+								   i - FirstLowInvalidHeapAttributeNumber);
+	}
+
+	return attrs;
+}
+
 /*
  * SeqRecheck -- access method routine to recheck a tuple in EvalPlanQual
  */
@@ -254,6 +288,12 @@ ExecInitSeqScan(SeqScan *node, EState *estate, int eflags)
 	scanstate->ss.ps.qual =
 		ExecInitQual(node->scan.plan.qual, (PlanState *) scanstate);
 
+	/*
+	 * If the table AM can skip reading columns, work out which ones we need.
+	 */
+	if (scanstate->ss.ss_currentRelation->rd_tableam->scan_set_projection != NULL)
+		scanstate->projected_attrs = SeqScanProjectedAttrs(scanstate);
+
 	/*
 	 * When EvalPlanQual() is not in use, assign ExecProcNode for this node
 	 * based on the presence of qual and projection. Each ExecSeqScan*()
@@ -371,6 +411,8 @@ ExecSeqScanInitializeDSM(SeqScanState *node,
 	shm_toc_insert(pcxt->toc, node->ss.ps.plan->plan_node_id, pscan);
 	node->ss.ss_currentScanDesc =
 		table_beginscan_parallel(node->ss.ss_currentRelation, pscan);
+	table_scan_set_projection(node->ss.ss_currentScanDesc,
+							  node->projected_attrs);
 }
 
 /* ----------------------------------------------------------------
@@ -404,4 +446,6 @@ ExecSeqScanInitializeWorker(SeqScanState *node,
 	pscan = shm_toc_lookup(pwcxt->toc, node->ss.ps.plan->plan_node_id, false);
 	node->ss.ss_currentScanDesc =
 		table_beginscan_parallel(node->ss.ss_currentRelation, pscan);
+	table_scan_set_projection(node->ss.ss_currentScanDesc,
+							  node->projected_attrs);
 }
@@ -903,6 +903,13 @@ use_physical_tlist(PlannerInfo *root, Path *path, int flags)
 	if (IsA(path, CustomPath))
 		return false;
 
+	/*
+	 * If the table AM can avoid reading columns that aren't needed, asking
+	 * for all of them would defeat that, so emit the exact tlist instead.
+	 */
+	if (rel->amflags & AMFLAG_HAS_COLUMN_PROJECTION)
+		return false;
+
 	/*
 	 * If a bitmap scan's tlist is empty, keep it as-is.  This may allow the
 	 * executor to skip heap page fetches, and in any case, the benefit of
@@ -58,6 +58,7 @@
 #include "storage/smgr.h"
 #include "storage/standby.h"
 #include "utils/memdebug.h"
+#include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/resowner.h"
@@ -95,6 +96,16 @@ typedef struct PrivateRefCountEntry
 /* 64 bytes, about the size of a cache line on common systems */
 #define REFCOUNT_ARRAY_ENTRIES 8
 
+/*
+ * Run of consecutive blocks being written by SyncCheckpointBufferRun(), for
+ * shared_buffer_writev_error_callback.
+ */
+typedef struct BufferWriteRun
+{
+	BufferTag	tag;			/* tag of the run's first block */
+	int			nblocks;		/* number of blocks in the run */
+} BufferWriteRun;
+
 /*
  * Status of buffers to checkpoint for a particular tablespace, used
  * internally in BufferSync.
@@ -516,12 +527,15 @@ static void BufferSync(int flags);
 static uint32 WaitBufHdrUnlocked(BufferDesc *buf);
 static int	SyncOneBuffer(int buf_id, bool skip_recently_used,
 						  WritebackContext *wb_context);
+static int	SyncCheckpointBufferRun(CkptSortItem *items, int nitems,
+									WritebackContext *wb_context);
 static void WaitIO(BufferDesc *buf);
 static bool StartBufferIO(BufferDesc *buf, bool forInput, bool nowait);
 static void TerminateBufferIO(BufferDesc *buf, bool clear_dirty,
 							  uint32 set_flag_bits, bool forget_owner);
 static void AbortBufferIO(Buffer buffer);
 static void shared_buffer_write_error_callback(void *arg);
+static void shared_buffer_writev_error_callback(void *arg);
 static void local_buffer_write_error_callback(void *arg);
 static inline BufferDesc *BufferAlloc(SMgrRelation smgr,
 									  char relpersistence,
@@ -3161,14 +3175,13 @@ BufferSync(int flags)
 		BufferDesc *bufHdr = NULL;
 		CkptTsStatus *ts_stat = (CkptTsStatus *)
 			DatumGetPointer(binaryheap_first(ts_heap));
+		int			nconsumed = 1;
 
 		buf_id = CkptBufferIds[ts_stat->index].buf_id;
 		Assert(buf_id != -1);
 
 		bufHdr = GetBufferDescriptor(buf_id);
 
-		num_processed++;
-
 		/*
 		 * We don't need to acquire the lock here, because we're only looking
 		 * at a single bit. It's possible that someone else writes the buffer
@@ -3183,21 +3196,50 @@ BufferSync(int flags)
 		 */
 		if (pg_atomic_read_u32(&bufHdr->state) & BM_CHECKPOINT_NEEDED)
 		{
-			if (SyncOneBuffer(buf_id, false, &wb_context) & BUF_WRITTEN)
+			int			nrun = 1;
+			int			nwritten;
+
+			/*
+			 * Find the run of blocks following this one in the same relation
+			 * fork that also need to be written, so they can be written with
+			 * a single vectored write.  Since the array is sorted, they're
+			 * right next to each other.  The tags in CkptBufferIds don't
+			 * include the database, and may be stale anyway, so
+			 * SyncCheckpointBufferRun() rechecks them against the buffers.
+			 */
+			while (nrun < io_combine_limit &&
+				   ts_stat->num_scanned + nrun < ts_stat->num_to_scan)
 			{
-				TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(buf_id);
-				PendingCheckpointerStats.buffers_written++;
-				num_written++;
+				CkptSortItem *prev = &CkptBufferIds[ts_stat->index + nrun - 1];
+				CkptSortItem *next = &CkptBufferIds[ts_stat->index + nrun];
+
+				if (next->relNumber != prev->relNumber ||
+					next->forkNum != prev->forkNum ||
+					next->blockNum != prev->blockNum + 1)
+					break;
+				nrun++;
 			}
+
+			nwritten = SyncCheckpointBufferRun(&CkptBufferIds[ts_stat->index],
+											   nrun, &wb_context);
+
+			for (i = 0; i < nwritten; i++)
+				TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(CkptBufferIds[ts_stat->index + i].buf_id);
+			PendingCheckpointerStats.buffers_written += nwritten;
+			num_written += nwritten;
+
+			nconsumed = Max(nwritten, 1);
 		}
 
+		num_processed += nconsumed;
+
 		/*
 		 * Measure progress independent of actually having to flush the buffer
 		 * - otherwise writing become unbalanced.
 		 */
-		ts_stat->progress += ts_stat->progress_slice;
-		ts_stat->num_scanned++;
-		ts_stat->index++;
+		ts_stat->progress += ts_stat->progress_slice * nconsumed;
+		ts_stat->num_scanned += nconsumed;
+		ts_stat->index += nconsumed;
 
 		/* Have all the buffers from the tablespace been processed? */
 		if (ts_stat->num_scanned == ts_stat->num_to_scan)
@@ -3612,6 +3654,211 @@ SyncOneBuffer(int buf_id, bool skip_recently_used, WritebackContext *wb_context)
 	return result | BUF_WRITTEN;
 }
 
+/*
+ * SyncCheckpointBufferRun -- write out a run of buffers for the checkpointer
+ *
+ * items points to nitems entries of the sorted checkpoint array, which are
+ * expected to describe consecutive blocks of one relation fork, the first of
+ * which is marked BM_CHECKPOINT_NEEDED.  The first buffer is written just
+ * like SyncOneBuffer() would.  Following buffers are added to the same
+ * vectored write as long as they still hold the expected block, need to be
+ * written for the checkpoint, and can be locked and have their I/O started
+ * without waiting; the first buffer failing that ends the run, and is left
+ * for the caller to deal with separately.
+ *
+ * Only the first buffer is ever waited for, so we can't deadlock against
+ * other backends while holding content locks on several buffers.
+ *
+ * Returns the number of buffers written, which are always a prefix of items.
+ * Zero means the first buffer was found clean.
+ */
+static int
+SyncCheckpointBufferRun(CkptSortItem *items, int nitems,
+						WritebackContext *wb_context)
+{
+	static PGIOAlignedBlock *checksum_copies = NULL;
+	BufferDesc *bufHdrs[MAX_IO_COMBINE_LIMIT];
+	const void *blocks[MAX_IO_COMBINE_LIMIT];
+	BufferDesc *first;
+	BufferTag	tag;
+	SMgrRelation reln;
+	BufferWriteRun run;
+	ErrorContextCallback errcallback;
+	instr_time	io_start;
+	XLogRecPtr	max_lsn = InvalidXLogRecPtr;
+	uint32		buf_state;
+	int			nbufs = 0;
+
+	Assert(nitems >= 1 && nitems <= MAX_IO_COMBINE_LIMIT);
+
+	/* A single block is no different from what SyncOneBuffer() does */
+	if (nitems == 1)
+		return (SyncOneBuffer(items[0].buf_id, false, wb_context) & BUF_WRITTEN) ? 1 : 0;
+
+	/* Pin and share-lock the first buffer, as in SyncOneBuffer() */
+	first = GetBufferDescriptor(items[0].buf_id);
+
+	ReservePrivateRefCountEntry();
+	ResourceOwnerEnlarge(CurrentResourceOwner);
+
+	buf_state = LockBufHdr(first);
+	if (!(buf_state & BM_VALID) || !(buf_state & BM_DIRTY))
+	{
+		UnlockBufHdr(first, buf_state);
+		return 0;
+	}
+	PinBuffer_Locked(first);
+	LWLockAcquire(BufferDescriptorGetContentLock(first), LW_SHARED);
+
+	if (!StartBufferIO(first, false, false))
+	{
+		LWLockRelease(BufferDescriptorGetContentLock(first));
+		UnpinBuffer(first);
+		return 0;
+	}
+	bufHdrs[nbufs++] = first;
+	tag = first->tag;
+
+	/*
+	 * Now try to add the following blocks.  Only BM_CHECKPOINT_NEEDED buffers
+	 * are taken, so that we don't write anything that was dirtied after the
+	 * checkpoint started.
+	 */
+	while (nbufs < nitems)
+	{
+		BufferDesc *bufHdr = GetBufferDescriptor(items[nbufs].buf_id);
+		BufferTag	expected = tag;
+
+		expected.blockNum = tag.blockNum + nbufs;
+
+		ReservePrivateRefCountEntry();
+		ResourceOwnerEnlarge(CurrentResourceOwner);
+
+		buf_state = LockBufHdr(bufHdr);
+		if (!BufferTagsEqual(&bufHdr->tag, &expected) ||
+			(buf_state & (BM_VALID | BM_DIRTY | BM_CHECKPOINT_NEEDED)) !=
+			(BM_VALID | BM_DIRTY | BM_CHECKPOINT_NEEDED))
+		{
+			UnlockBufHdr(bufHdr, buf_state);
+			break;
+		}
+		PinBuffer_Locked(bufHdr);
+
+		if (!LWLockConditionalAcquire(BufferDescriptorGetContentLock(bufHdr),
+									  LW_SHARED))
+		{
+			UnpinBuffer(bufHdr);
+			break;
+		}
+		if (!StartBufferIO(bufHdr, false, true))
+		{
+			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
+			UnpinBuffer(bufHdr);
+			break;
+		}
+		bufHdrs[nbufs++] = bufHdr;
+	}
+
+	/* Setup error traceback support for ereport(), covering the whole run */
+	run.tag = tag;
+	run.nblocks = nbufs;
+	errcallback.callback = shared_buffer_writev_error_callback;
+	errcallback.arg = &run;
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	reln = smgropen(BufTagGetRelFileLocator(&tag), INVALID_PROC_NUMBER);
+
+	/*
+	 * Collect the LSNs, and clear BM_JUST_DIRTIED, as FlushBuffer() does.
+	 * The WAL only has to be flushed once, up to the highest LSN of the run.
+	 */
+	for (int i = 0; i < nbufs; i++)
+	{
+		BufferDesc *bufHdr = bufHdrs[i];
+		XLogRecPtr	recptr;
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_START(BufTagGetForkNum(&tag),
+											bufHdr->tag.blockNum,
+											reln->smgr_rlocator.locator.spcOid,
+											reln->smgr_rlocator.locator.dbOid,
+											reln->smgr_rlocator.locator.relNumber);
+
+		buf_state = LockBufHdr(bufHdr);
+		recptr = BufferGetLSN(bufHdr);
+		buf_state &= ~BM_JUST_DIRTIED;
+		UnlockBufHdr(bufHdr, buf_state);
+
+		/* See FlushBuffer() for why only permanent buffers are considered */
+		if ((buf_state & BM_PERMANENT) && recptr > max_lsn)
+			max_lsn = recptr;
+	}
+
+	if (!XLogRecPtrIsInvalid(max_lsn))
+		XLogFlush(max_lsn);
+
+	/*
+	 * With checksums enabled we have to write private copies of the pages,
+	 * because other backends might set hint bits while we hold only a share
+	 * lock.  PageSetChecksumCopy() has room for just one page, so keep our
+	 * own space for a full run.
+	 */
+	if (DataChecksumsEnabled() && checksum_copies == NULL)
+		checksum_copies = MemoryContextAllocAligned(TopMemoryContext,
+													MAX_IO_COMBINE_LIMIT * BLCKSZ,
+													PG_IO_ALIGN_SIZE,
+													0);
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		Page		page = (Page) BufHdrGetBlock(bufHdrs[i]);
+
+		if (DataChecksumsEnabled() && !PageIsNew(page))
+		{
+			memcpy(checksum_copies[i].data, page, BLCKSZ);
+			PageSetChecksumInplace((Page) checksum_copies[i].data,
+								   tag.blockNum + i);
+			blocks[i] = checksum_copies[i].data;
+		}
+		else
+			blocks[i] = page;
+	}
+
+	io_start = pgstat_prepare_io_time(track_io_timing);
+
+	smgrwritev(reln, BufTagGetForkNum(&tag), tag.blockNum,
+			   blocks, nbufs, false);
+
+	pgstat_count_io_op_time(IOOBJECT_RELATION, IOCONTEXT_NORMAL,
+							IOOP_WRITE, io_start, nbufs, (uint64) nbufs * BLCKSZ);
+
+	pgBufferUsage.shared_blks_written += nbufs;
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		BufferDesc *bufHdr = bufHdrs[i];
+		BufferTag	buftag = bufHdr->tag;
+
+		TerminateBufferIO(bufHdr, true, 0, true);
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_DONE(BufTagGetForkNum(&buftag),
+										   buftag.blockNum,
+										   reln->smgr_rlocator.locator.spcOid,
+										   reln->smgr_rlocator.locator.dbOid,
+										   reln->smgr_rlocator.locator.relNumber);
+
+		LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
+		UnpinBuffer(bufHdr);
+
+		ScheduleBufferTagForWriteback(wb_context, IOCONTEXT_NORMAL, &buftag);
+	}
+
+	/* Pop the error context stack */
+	error_context_stack = errcallback.previous;
+
+	return nbufs;
+}
+
 /*
  *		AtEOXact_Buffers - clean up at end of transaction.
  *
@@ -5696,6 +5943,28 @@ shared_buffer_write_error_callback(void *arg)
 							   BufTagGetForkNum(&bufHdr->tag)).str);
 }
 
+/*
+ * Error context callback for errors occurring during a vectored write of
+ * a run of shared buffers.
+ */
+static void
+shared_buffer_writev_error_callback(void *arg)
+{
+	BufferWriteRun *run = (BufferWriteRun *) arg;
+
+	if (run->nblocks == 1)
+		errcontext("writing block %u of relation %s",
+				   run->tag.blockNum,
+				   relpathperm(BufTagGetRelFileLocator(&run->tag),
+							   BufTagGetForkNum(&run->tag)).str);
+	else
+		errcontext("writing blocks %u..%u of relation %s",
+				   run->tag.blockNum,
+				   run->tag.blockNum + run->nblocks - 1,
+				   relpathperm(BufTagGetRelFileLocator(&run->tag),
+							   BufTagGetForkNum(&run->tag)).str);
+}
+
 /*
  * Error context callback for errors occurring during local buffer writes.
  */
@@ -1002,10 +1002,18 @@ BuildCachedPlan(CachedPlanSource *plansource, List *qlist,
 											 ALLOCSET_START_SMALL_SIZES);
 		MemoryContextCopyAndSetIdentifier(plan_context, plansource->query_string);
 
+		/*
+		 * stmt_context is a child of plan_context, so it can share the
+		 * latter's copy of the query string as its identifier.  Besides
+		 * saving another copy of a possibly long query text per cached plan,
+		 * this keeps the identifier valid across the MemoryContextReset() in
+		 * UpdateCachedPlan(), which would free a copy made in stmt_context
+		 * itself.
+		 */
 		stmt_context = AllocSetContextCreate(CurrentMemoryContext,
 											 "CachedPlan PlannedStmts",
 											 ALLOCSET_START_SMALL_SIZES);
-		MemoryContextCopyAndSetIdentifier(stmt_context, plansource->query_string);
+		MemoryContextSetIdentifier(stmt_context, plan_context->ident);
 		MemoryContextSetParent(stmt_context, plan_context);
 
 		MemoryContextSwitchTo(stmt_context);
@@ -790,7 +790,8 @@ my %pgdump_runs = (
 #
 # There can be a flag called 'lz4', which can be set if the test
 # case depends on LZ4.  Tests marked with this flag are skipped if
-# the build used does not support LZ4.
+# the build used does not support LZ4.  Likewise, 'zstd' marks tests
+# depending on ZSTD.
 #
 # Building of this hash takes a bit of time as all of the regexps
 # included in it are compiled.  This greatly improves performance
@@ -3466,6 +3467,30 @@ my %tests = (
 		},
 	},
 
+	'CREATE TABLE test_compression_zstd' => {
+		create_order => 3,
+		create_sql => 'CREATE TABLE dump_test.test_compression_zstd (
+						   col1 int,
+						   col2 text COMPRESSION zstd
+					   );',
+		regexp => qr/^
+			\QCREATE TABLE dump_test.test_compression_zstd (\E\n
+			\s+\Qcol1 integer,\E\n
+			\s+\Qcol2 text\E\n
+			\);\n
+			.*
+			\QALTER TABLE ONLY dump_test.test_compression_zstd ALTER COLUMN col2 SET COMPRESSION zstd;\E\n
+			/xms,
+		zstd => 1,
+		like =>
+		  { %full_runs, %dump_test_schema_runs, section_pre_data => 1, },
+		unlike => {
+			exclude_dump_test_schema => 1,
+			no_toast_compression => 1,
+			only_dump_measurement => 1,
+		},
+	},
+
 	'CREATE TABLE measurement PARTITIONED BY' => {
 		create_order => 90,
 		create_sql => 'CREATE TABLE dump_test.measurement (
@@ -4956,6 +4981,13 @@ foreach my $test (
 			next;
 		}
 
+		# Skip tests specific to ZSTD if this build does not support
+		# this option.
+		if (!$supports_zstd && defined($tests{$test}->{zstd}))
+		{
+			next;
+		}
+
 		# Normalize command ending: strip all line endings, add
 		# semicolon if missing, add two newlines.
 		my $create_sql = $tests{$test}->{create_sql};
@@ -5243,6 +5275,13 @@ foreach my $run (sort keys %pgdump_runs)
 			next;
 		}
 
+		# Skip tests specific to ZSTD if this build does not support
+		# this option.
+		if (!$supports_zstd && defined($tests{$test}->{zstd}))
+		{
+			next;
+		}
+
 		if ($run_db ne $test_db)
 		{
 			next;
@@ -989,6 +989,8 @@ typedef struct BTScanPosData
 	int			firstItem;		/* first valid index in items[] */
 	int			lastItem;		/* last valid index in items[] */
 	int			itemIndex;		/* current index in items[] */
+	int			prefetchIndex;	/* last items[] entry whose heap block was
+								 * prefetched, see _bt_prefetch_heap */
 
 	BTScanPosItem items[MaxTIDsPerBTreePage];	/* MUST BE LAST */
 } BTScanPosData;
@@ -1070,6 +1072,23 @@ typedef struct BTScanOpaqueData
 	 */
 	int			markItemIndex;	/* itemIndex, or -1 if not valid */
 
+	/*
+	 * Heap prefetching for plain and index-only scans.  prefetchDistance is
+	 * the most items ahead of the one being returned we prefetch heap blocks
+	 * for (0 disables prefetching, -1 means btrescan has yet to set it up).
+	 * prefetchTarget is how far ahead we currently go; it is negative while
+	 * we wait for the scan to return a few tuples first.  prefetchNread is
+	 * the backend's count of blocks read when we last looked, see
+	 * _bt_prefetch_heap.  prefetchBlock is the last block we prefetched, to
+	 * skip runs of TIDs on the same heap page.  vmBuffer is used to skip
+	 * all-visible blocks in index-only scans.
+	 */
+	int			prefetchDistance;
+	int			prefetchTarget;
+	int64		prefetchNread;
+	BlockNumber prefetchBlock;
+	Buffer		vmBuffer;
+
 	/* keep these last in struct for efficiency */
 	BTScanPosData currPos;		/* current position data */
 	BTScanPosData markPos;		/* marked position, if any */
@@ -352,6 +352,19 @@ typedef struct TableAmRoutine
 									 ScanDirection direction,
 									 TupleTableSlot *slot);
 
+	/*
+	 * Optional callback to inform the AM which columns the caller is going
+	 * to read from tuples returned by `scan`.  `attrs` contains attribute
+	 * numbers offset by FirstLowInvalidHeapAttributeNumber, as returned by
+	 * pull_varattnos(), with whole-row references already expanded; NULL
+	 * means no columns are needed.  Columns not in the set may be returned
+	 * as NULLs, which allows AMs that store columns separately to avoid
+	 * reading them at all.  Called right after the scan is started, before
+	 * the first tuple is fetched; the set remains valid for the scan's
+	 * lifetime.
+	 */
+	void		(*scan_set_projection) (TableScanDesc scan, Bitmapset *attrs);
+
 	/*-----------
 	 * Optional functions to provide scanning for ranges of ItemPointers.
 	 * Implementations must either provide both of these functions, or neither
@@ -1041,6 +1054,17 @@ table_scan_getnextslot(TableScanDesc sscan, ScanDirection direction, TupleTableS
 	return sscan->rs_rd->rd_tableam->scan_getnextslot(sscan, direction, slot);
 }
 
+/*
+ * Tell the AM which columns will be read from tuples returned by `sscan`.
+ * This is a no-op for AMs that don't support column projection.
+ */
+static inline void
+table_scan_set_projection(TableScanDesc sscan, Bitmapset *attrs)
+{
+	if (sscan->rs_rd->rd_tableam->scan_set_projection != NULL)
+		sscan->rs_rd->rd_tableam->scan_set_projection(sscan, attrs);
+}
+
 /* ----------------------------------------------------------------------------
  * TID Range scanning related functions.
  * ----------------------------------------------------------------------------
@@ -1620,6 +1620,8 @@ typedef struct SeqScanState
 {
 	ScanState	ss;				/* its first field is NodeTag */
 	Size		pscan_len;		/* size of parallel heap scan descriptor */
+	Bitmapset  *projected_attrs;	/* columns needed from the table AM, for
+									 * scan_set_projection; NULL if none */
 } SeqScanState;
 
 /* ----------------
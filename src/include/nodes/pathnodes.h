@@ -848,6 +848,7 @@ typedef struct PartitionSchemeData *PartitionScheme;
 
 /* Bitmask of flags supported by table AMs */
 #define AMFLAG_HAS_TID_RANGE (1 << 0)
+#define AMFLAG_HAS_COLUMN_PROJECTION (1 << 1)
 
 typedef enum RelOptKind
 {
@@ -31,6 +31,8 @@ step notifys1	{
 	ROLLBACK TO SAVEPOINT s2;
 	COMMIT;
 }
+step notifyb	{ BEGIN; NOTIFY c1, 'late'; }
+step notifyc	{ COMMIT; }
 step usage		{ SELECT pg_notification_queue_usage() > 0 AS nonzero; }
 step bignotify	{ SELECT count(pg_notify('c1', s::text)) FROM generate_series(1, 1000) s; }
 teardown		{ UNLISTEN *; }
@@ -39,6 +41,7 @@ teardown		{ UNLISTEN *; }
 
 session listener
 step llisten	{ LISTEN c1; LISTEN c2; }
+step lunlisten1	{ UNLISTEN c1; }
 step lcheck		{ SELECT 1 AS x; }
 step lbegin		{ BEGIN; }
 step lbegins	{ BEGIN ISOLATION LEVEL SERIALIZABLE; }
@@ -53,6 +56,13 @@ step l2begin	{ BEGIN; }
 step l2commit	{ COMMIT; }
 step l2stop		{ UNLISTEN *; }
 
+# And a listener in the same database that listens on a different channel.
+
+session listener3
+step l3listen	{ LISTEN c3; }
+step l3check	{ SELECT 1 AS x; }
+teardown		{ UNLISTEN *; }
+
 
 # Trivial cases.
 permutation listenc notify1 notify2 notify3 notifyf
@@ -73,6 +83,19 @@ permutation listenc llisten notify1 notify2 notify3 notifyf lcheck
 # and notify queue is not empty
 permutation l2listen l2begin notify1 lbegins llisten lcommit l2commit l2stop
 
+# Only listeners that may be interested in a notification are signaled, so
+# check that listeners on other channels still see notifications on their
+# own channels once some arrive, skipping the others.
+permutation llisten l3listen notify1 notify2 lcheck l3check notify3 l3check lcheck
+
+# A LISTEN must be effective for a notification committed right after it,
+# even though the notifying transaction started before the LISTEN committed.
+permutation lbegin llisten notifyb lcommit notifyc lcheck
+
+# After UNLISTEN of one channel, notifications on the remaining channel must
+# still be delivered.
+permutation llisten lunlisten1 notify1 notify2 lcheck
+
 # Verify that pg_notification_queue_usage correctly reports a non-zero result,
 # after submitting notifications while another connection is listening for
 # those notifications and waiting inside an active transaction.  We have to
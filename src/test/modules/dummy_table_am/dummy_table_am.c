@@ -0,0 +1,86 @@
+/*-------------------------------------------------------------------------
+ *
+ * dummy_table_am.c
+ *		Table AM for testing optional table AM callbacks.
+ *
+ * The AM stores its data exactly like heap, but additionally implements
+ * optional callbacks that heap doesn't, reporting what the core code passes
+ * to them.
+ *
+ * Portions Copyright (c) 1996-2025, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/test/modules/dummy_table_am/dummy_table_am.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/sysattr.h"
+#include "access/tableam.h"
+#include "catalog/pg_am_d.h"
+#include "fmgr.h"
+#include "lib/stringinfo.h"
+#include "nodes/bitmapset.h"
+#include "utils/rel.h"
+
+PG_MODULE_MAGIC;
+
+/* Table AM routine, copied from heap's on first use */
+static TableAmRoutine dummy_table_am_methods;
+static bool dummy_table_am_initialized = false;
+
+/* Handler for table AM */
+PG_FUNCTION_INFO_V1(dummy_table_am_handler);
+
+/*
+ * Report the set of columns the executor asks the scan to return.
+ */
+static void
+dtam_scan_set_projection(TableScanDesc scan, Bitmapset *attrs)
+{
+	StringInfoData buf;
+	int			x = -1;
+
+	initStringInfo(&buf);
+	while ((x = bms_next_member(attrs, x)) >= 0)
+	{
+		AttrNumber	attnum = x + FirstLowInvalidHeapAttributeNumber;
+
+		if (buf.len > 0)
+			appendStringInfoString(&buf, ", ");
+		appendStringInfo(&buf, "%d", attnum);
+	}
+
+	ereport(NOTICE,
+			(errmsg("projection for scan on \"%s\": {%s}",
+					RelationGetRelationName(scan->rs_rd),
+					buf.data)));
+
+	pfree(buf.data);
+}
+
+/*
+ * Keep TOAST data in plain heap tables; heap's own callback would make the
+ * TOAST table use this AM too.
+ */
+static Oid
+dtam_relation_toast_am(Relation rel)
+{
+	return HEAP_TABLE_AM_OID;
+}
+
+Datum
+dummy_table_am_handler(PG_FUNCTION_ARGS)
+{
+	if (!dummy_table_am_initialized)
+	{
+		dummy_table_am_methods = *GetHeapamTableAmRoutine();
+		dummy_table_am_methods.relation_toast_am = dtam_relation_toast_am;
+		dummy_table_am_methods.scan_set_projection = dtam_scan_set_projection;
+		dummy_table_am_initialized = true;
+	}
+
+	PG_RETURN_POINTER(&dummy_table_am_methods);
+}
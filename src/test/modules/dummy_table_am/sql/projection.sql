@@ -0,0 +1,48 @@
+-- Tests for the scan_set_projection table AM callback
+CREATE EXTENSION dummy_table_am;
+
+CREATE TABLE dtam_tbl (a int, b int, c text) USING dummy_table_am;
+INSERT INTO dtam_tbl SELECT i, i % 10, 'row ' || i FROM generate_series(1, 1000) i;
+ANALYZE dtam_tbl;
+
+-- Columns referenced by the targetlist and the qual
+SELECT a, c FROM dtam_tbl WHERE a = 42;
+
+-- A column referenced only by the qual
+SELECT count(*) FROM dtam_tbl WHERE b = 3;
+
+-- No columns at all
+SELECT count(*) FROM dtam_tbl;
+
+-- A whole-row reference needs every column
+SELECT t FROM dtam_tbl t WHERE t.a = 7;
+
+-- System columns are included too
+SELECT ctid, a FROM dtam_tbl WHERE a = 1;
+
+-- The planner doesn't use a physical tlist for such relations
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT count(*) FROM dtam_tbl WHERE b = 3;
+
+-- Parallel scans pass the set to each process doing the scan.  Plan two
+-- workers but let at most one run, and keep the leader out of it, so that
+-- exactly one process scans: the worker, or the leader if no worker could
+-- be launched.
+ALTER TABLE dtam_tbl SET (parallel_workers = 2);
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+SET max_parallel_workers_per_gather = 2;
+SET max_parallel_workers = 1;
+SET parallel_leader_participation = off;
+EXPLAIN (COSTS OFF)
+SELECT sum(a) FROM dtam_tbl WHERE b = 5;
+SELECT sum(a) FROM dtam_tbl WHERE b = 5;
+RESET parallel_setup_cost;
+RESET parallel_tuple_cost;
+RESET min_parallel_table_scan_size;
+RESET max_parallel_workers_per_gather;
+RESET max_parallel_workers;
+RESET parallel_leader_participation;
+
+DROP TABLE dtam_tbl;
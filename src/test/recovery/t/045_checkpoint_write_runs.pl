@@ -0,0 +1,74 @@
+
+# Copyright (c) 2025, PostgreSQL Global Development Group
+
+# Check that a checkpoint writes out every dirty buffer when it combines
+# runs of consecutive dirty blocks into vectored writes.  If any buffer were
+# left behind, the changes made before the checkpoint would be lost by crash
+# recovery, which only replays WAL from the checkpoint's redo pointer.
+
+use strict;
+use warnings FATAL => 'all';
+
+use PostgreSQL::Test::Cluster;
+use Test::More;
+
+my $node = PostgreSQL::Test::Cluster->new('main');
+$node->init;
+# Keep the runs short, so that long ranges of dirty blocks are split into
+# several writes, and make sure nothing else writes out our buffers.
+$node->append_conf(
+	'postgresql.conf', q[
+autovacuum = off
+io_combine_limit = 4
+bgwriter_lru_maxpages = 0
+shared_buffers = 16MB
+]);
+$node->start;
+
+# Leave room on each page for HOT updates, so that updates only dirty the
+# blocks they touch.
+$node->safe_psql(
+	'postgres', q[
+CREATE TABLE ckpt_runs (id int, val int) WITH (fillfactor = 50);
+INSERT INTO ckpt_runs SELECT g, 0 FROM generate_series(1, 20000) g;
+CHECKPOINT;
+]);
+
+my $nblocks = $node->safe_psql('postgres',
+	"SELECT pg_relation_size('ckpt_runs') / current_setting('block_size')::int"
+);
+cmp_ok($nblocks, '>', 50, 'table spans enough blocks');
+
+# Dirty runs of various lengths separated by clean blocks: the first seven
+# blocks of every ten, then every third block, then everything from block
+# 40 on.
+$node->safe_psql(
+	'postgres', q[
+UPDATE ckpt_runs SET val = 1 WHERE (ctid::text::point)[0]::int % 10 < 7;
+UPDATE ckpt_runs SET val = val + 10 WHERE (ctid::text::point)[0]::int % 3 = 0;
+UPDATE ckpt_runs SET val = val + 100 WHERE (ctid::text::point)[0]::int >= 40;
+]);
+
+my $expected = $node->safe_psql('postgres',
+	'SELECT count(*), sum(val) FROM ckpt_runs');
+
+my $written_before = $node->safe_psql('postgres',
+	'SELECT buffers_written FROM pg_stat_checkpointer');
+$node->safe_psql('postgres', 'CHECKPOINT');
+# The checkpointer reports its statistics only after waking us up.
+ok( $node->poll_query_until(
+		'postgres',
+		"SELECT buffers_written - $written_before >= $nblocks - 10 FROM pg_stat_checkpointer"
+	),
+	'checkpoint wrote the dirty blocks');
+
+# Crash, so that only what the checkpoint wrote survives besides the WAL
+# after its redo pointer.
+$node->stop('immediate');
+$node->start;
+
+is( $node->safe_psql('postgres', 'SELECT count(*), sum(val) FROM ckpt_runs'),
+	$expected,
+	'all changes made before the checkpoint survive crash recovery');
+
+done_testing();
@@ -348,6 +348,45 @@ VACUUM delete_test_table;
 -- need to insert some rows to cause the fast root page to split.
 INSERT INTO delete_test_table SELECT i, 1, 2, 3 FROM generate_series(1,1000) i;
 
+--
+-- Test heap prefetching during index scans.  Scatter the keys over the heap,
+-- so that consecutive index entries point to different heap blocks, and
+-- check that scans still return the right rows however they move.
+--
+CREATE TABLE btree_prefetch_tbl (x int, pad text)
+  WITH (fillfactor = 10, autovacuum_enabled = off);
+INSERT INTO btree_prefetch_tbl
+  SELECT (g * 379) % 1000, 'p' || g FROM generate_series(0, 999) g;
+CREATE INDEX btree_prefetch_idx ON btree_prefetch_tbl (x);
+VACUUM ANALYZE btree_prefetch_tbl;
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+explain (costs off)
+SELECT count(pad), sum(x) FROM btree_prefetch_tbl WHERE x >= 100;
+SELECT count(pad), sum(x) FROM btree_prefetch_tbl WHERE x >= 100;
+SELECT x, pad FROM btree_prefetch_tbl WHERE x >= 100 ORDER BY x LIMIT 1;
+BEGIN;
+DECLARE c SCROLL CURSOR FOR
+  SELECT x, pad FROM btree_prefetch_tbl WHERE x >= 100 ORDER BY x;
+MOVE 400 IN c;
+FETCH 2 FROM c;
+MOVE BACKWARD 300 IN c;
+FETCH BACKWARD 2 FROM c;
+MOVE FORWARD ALL IN c;
+FETCH BACKWARD 2 FROM c;
+MOVE ABSOLUTE 450 IN c;
+FETCH 2 FROM c;
+COMMIT;
+-- Index-only scans skip all-visible blocks, so have some that aren't
+UPDATE btree_prefetch_tbl SET pad = pad || 'u' WHERE x % 7 = 0;
+explain (costs off)
+SELECT count(*), sum(x) FROM btree_prefetch_tbl WHERE x < 900;
+SELECT count(*), sum(x) FROM btree_prefetch_tbl WHERE x < 900;
+SELECT x FROM btree_prefetch_tbl WHERE x < 900 ORDER BY x DESC OFFSET 500 LIMIT 2;
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+DROP TABLE btree_prefetch_tbl;
+
 -- Test unsupported btree opclass parameters
 create index on btree_tall_tbl (id int4_ops(foo=1));
 
@@ -100,9 +100,12 @@ CREATE TABLE cmdata3(f1 text);
 CREATE TABLE cminh() INHERITS (cmdata, cmdata3);
 
 -- test default_toast_compression GUC
+-- (terse, as the HINT lists the methods available in this build)
+\set VERBOSITY terse
 SET default_toast_compression = '';
 SET default_toast_compression = 'I do not exist compression';
 SET default_toast_compression = 'lz4';
+\set VERBOSITY default
 SET default_toast_compression = 'pglz';
 
 -- test alter compression method
@@ -0,0 +1,96 @@
+-- Tests for TOAST compression with zstd
+
+-- skip test if the server was built without zstd support
+SELECT NOT(enumvals @> '{zstd}') AS skip_test FROM pg_settings WHERE
+  name = 'default_toast_compression' \gset
+\if :skip_test
+\quit
+\endif
+
+\set HIDE_TOAST_COMPRESSION false
+
+-- ensure we get stable results regardless of installation's default
+SET default_toast_compression = 'pglz';
+
+-- test creating table with compression method
+CREATE TABLE cmdata_zstd(f1 TEXT COMPRESSION zstd);
+INSERT INTO cmdata_zstd VALUES(repeat('1234567890', 1004));
+\d+ cmdata_zstd
+
+-- verify stored compression method in the data
+SELECT pg_column_compression(f1) FROM cmdata_zstd;
+
+-- decompress the whole value, and data slices from various offsets
+SELECT f1 = repeat('1234567890', 1004) FROM cmdata_zstd;
+SELECT SUBSTR(f1, 1, 10) FROM cmdata_zstd;
+SELECT SUBSTR(f1, 2000, 50) FROM cmdata_zstd;
+SELECT SUBSTR(f1, 10031, 20) FROM cmdata_zstd;
+
+-- test externally stored compressed data
+CREATE FUNCTION large_val_zstd() RETURNS TEXT LANGUAGE SQL AS
+'select array_agg(fipshash(g::text))::text from generate_series(1, 256) g';
+INSERT INTO cmdata_zstd SELECT large_val_zstd() || repeat('a', 4000);
+SELECT pg_column_compression(f1) FROM cmdata_zstd;
+SELECT SUBSTR(f1, 200, 5) FROM cmdata_zstd;
+SELECT length(f1), md5(f1) = md5(large_val_zstd() || repeat('a', 4000))
+  FROM cmdata_zstd WHERE f1 LIKE '{%';
+
+-- copy to a table using a different compression method
+CREATE TABLE cmmove_zstd(f1 text COMPRESSION pglz);
+INSERT INTO cmmove_zstd SELECT * FROM cmdata_zstd;
+SELECT pg_column_compression(f1) FROM cmmove_zstd;
+SELECT length(f1) FROM cmmove_zstd;
+
+-- test LIKE INCLUDING COMPRESSION
+CREATE TABLE cmdata2_zstd (LIKE cmdata_zstd INCLUDING COMPRESSION);
+\d+ cmdata2_zstd
+DROP TABLE cmdata2_zstd;
+
+-- test default_toast_compression GUC
+SET default_toast_compression = 'zstd';
+CREATE TABLE cmdata2_zstd(f1 text);
+\d+ cmdata2_zstd
+INSERT INTO cmdata2_zstd VALUES (repeat('123456789', 4004));
+SELECT pg_column_compression(f1) FROM cmdata2_zstd;
+SET default_toast_compression = 'pglz';
+
+-- test alter compression method
+CREATE TABLE cmdata3_zstd(f1 text COMPRESSION pglz);
+INSERT INTO cmdata3_zstd VALUES (repeat('123456789', 4004));
+ALTER TABLE cmdata3_zstd ALTER COLUMN f1 SET COMPRESSION zstd;
+INSERT INTO cmdata3_zstd VALUES (repeat('123456789', 4004));
+\d+ cmdata3_zstd
+SELECT pg_column_compression(f1) FROM cmdata3_zstd;
+
+-- VACUUM FULL does not recompress
+VACUUM FULL cmdata3_zstd;
+SELECT pg_column_compression(f1) FROM cmdata3_zstd;
+
+-- test compression with partition
+CREATE TABLE cmpart_zstd(f1 text COMPRESSION zstd) PARTITION BY HASH(f1);
+CREATE TABLE cmpart1_zstd PARTITION OF cmpart_zstd
+  FOR VALUES WITH (MODULUS 2, REMAINDER 0);
+CREATE TABLE cmpart2_zstd(f1 text COMPRESSION pglz);
+ALTER TABLE cmpart_zstd ATTACH PARTITION cmpart2_zstd
+  FOR VALUES WITH (MODULUS 2, REMAINDER 1);
+INSERT INTO cmpart_zstd VALUES (repeat('123456789', 1004));
+INSERT INTO cmpart_zstd VALUES (repeat('123456789', 4004));
+SELECT pg_column_compression(f1) FROM cmpart1_zstd;
+SELECT pg_column_compression(f1) FROM cmpart2_zstd;
+
+-- test expression index
+CREATE TABLE cmdata4_zstd (f1 TEXT COMPRESSION pglz, f2 TEXT COMPRESSION zstd);
+CREATE UNIQUE INDEX idx1_zstd ON cmdata4_zstd ((f1 || f2));
+INSERT INTO cmdata4_zstd VALUES((SELECT array_agg(fipshash(g::TEXT))::TEXT FROM
+generate_series(1, 50) g), VERSION());
+
+-- check data is ok
+SELECT length(f1) FROM cmdata_zstd;
+SELECT length(f1) FROM cmdata2_zstd;
+SELECT length(f1) FROM cmdata3_zstd;
+
+DROP TABLE cmdata_zstd, cmdata2_zstd, cmdata3_zstd, cmdata4_zstd, cmmove_zstd,
+  cmpart_zstd;
+DROP FUNCTION large_val_zstd;
+
+\set HIDE_TOAST_COMPRESSION true
@@ -381,6 +381,29 @@ RESET enable_seqscan;
 DROP INDEX hash_tuplesort_idx;
 RESET maintenance_work_mem;
 
+-- Test parallel hash index build, which is only used for sorted builds.  The
+-- parallel_workers setting lets workers run despite the low
+-- maintenance_work_mem needed to force the sort.
+CREATE TABLE hash_parallel_heap WITH (parallel_workers = 2) AS
+  SELECT stringu1 FROM tenk1;
+BEGIN;
+SET LOCAL maintenance_work_mem = '1MB';
+SET LOCAL max_parallel_maintenance_workers = 2;
+CREATE INDEX hash_parallel_idx ON hash_parallel_heap USING hash (stringu1 name_ops) WITH (fillfactor = 10);
+COMMIT;
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+EXPLAIN (COSTS OFF)
+SELECT count(*) FROM hash_parallel_heap WHERE stringu1 = 'TVAAAA';
+SELECT count(*) FROM hash_parallel_heap WHERE stringu1 = 'TVAAAA';
+-- check that all the rows can be found through the index
+SELECT sum((SELECT count(*) FROM hash_parallel_heap h
+            WHERE h.stringu1 = t.stringu1))
+  FROM (SELECT DISTINCT stringu1 FROM tenk1) t;
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+DROP TABLE hash_parallel_heap;
+
 
 --
 -- Test unique null behavior
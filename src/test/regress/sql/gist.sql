@@ -37,6 +37,24 @@ vacuum analyze gist_point_tbl;
 alter index gist_pointidx SET (fillfactor = 40);
 reindex index gist_pointidx;
 
+-- rebuild it again using parallel workers for the sorted build; the
+-- parallel_workers setting makes sure they are requested, as the DEBUG
+-- message shows
+alter table gist_point_tbl set (parallel_workers = 2);
+begin;
+set local max_parallel_maintenance_workers = 2;
+set local log_temp_files = -1;
+set local client_min_messages = debug1;
+reindex index gist_pointidx;
+commit;
+alter table gist_point_tbl reset (parallel_workers);
+
+-- check that the parallel build indexed all the remaining rows
+begin;
+set local enable_seqscan = off;
+select count(*) from gist_point_tbl where p <@ box(point(0,0), point(100000, 100000));
+commit;
+
 --
 -- Test Index-only plans on GiST indexes
 --